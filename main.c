@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include "file_operations.h"
+#include "parallel_decode.h"
 
 // Функция вывода справки по использованию
 void print_help() {
@@ -9,20 +11,27 @@ void print_help() {
     printf("Использование:\n");
     printf("  Кодирование:   huffman encode <входной_файл> <сжатый_файл>\n");
     printf("  Декодирование: huffman decode <сжатый_файл> <выходной_файл>\n");
+    printf("  Параллельное декодирование: huffman pdecode <сжатый_файл> <выходной_файл> [потоки]\n");
     printf("\nПримеры:\n");
     printf("  huffman encode document.txt compressed.bin\n");
     printf("  huffman decode compressed.bin restored.txt\n");
+    printf("  huffman pdecode compressed.bin restored.txt\n");
+    printf("  huffman pdecode compressed.bin restored.txt 8\n");
     printf("\nОсобенности:\n");
     printf("  • Сжатый файл содержит дерево Хаффмана и закодированные данные\n");
     printf("  • Возможно многократное декодирование без потери информации\n");
     printf("  • Поддерживаются файлы любого типа и размера\n");
+    printf("  • pdecode декодирует существующие файлы на нескольких ядрах без перекодирования\n");
+    printf("    (по умолчанию потоков столько же, сколько ядер)\n");
 }
 
 int main(int argc, char *argv[]) {
     printf("=== Программа кодирования Хаффмана ===\n");
     
     // Проверка количества аргументов
-    if (argc != 4) {
+    // pdecode допускает необязательное количество потоков
+    int pdecode_threads = (argc == 5 && strcmp(argv[1], "pdecode") == 0);
+    if (argc != 4 && !pdecode_threads) {
         printf("Ошибка: неверное количество аргументов (ожидается 3, получено %d)\n\n", argc - 1);
         print_help();
         return 1;
@@ -50,6 +59,18 @@ int main(int argc, char *argv[]) {
         
         printf("Декодирование завершено успешно!\n");
     }
+    // Обработка команды pdecode
+    else if (strcmp(argv[1], "pdecode") == 0) {
+        printf("Режим: ПАРАЛЛЕЛЬНОЕ ДЕКОДИРОВАНИЕ\n");
+        printf("Входной файл: %s\n", argv[2]);
+        printf("Выходной файл: %s\n", argv[3]);
+        printf("Начато декодирование...\n");
+        
+        int threads = pdecode_threads ? atoi(argv[4]) : 0;
+        parallel_decode_file(argv[2], argv[3], threads);
+        
+        printf("Декодирование завершено успешно!\n");
+    }
     // Неизвестная команда
     else {
         printf("Ошибка: неизвестная команда '%s'\n\n", argv[1]);
@@ -0,0 +1,320 @@
+#include "parallel_decode.h"
+#include "bits.h"
+#include "file_operations.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Параметры параллельного декодирования
+#define PARALLEL_MAX_THREADS 64        // Максимальное количество потоков
+#define PARALLEL_CHUNK_BYTES 262144    // Размер участка сжатых данных на поток (в байтах)
+#define PARALLEL_SYNC_WINDOW 4096      // Сколько начал кодов запоминается для синхронизации
+
+// Участок битового потока, декодируемый одним потоком
+typedef struct DecodeChunk {
+    const unsigned char *data;   // Закодированные данные (отображены в память)
+    long total_bits;             // Общее количество бит в потоке
+    HuffmanNode *root;           // Корень дерева Хаффмана
+    struct DecodeChunk *next;    // Следующий участок пачки (NULL для последнего)
+    long start_bit;              // Позиция, с которой начато декодирование
+    long end_bit;                // Конец участка (не включая)
+    long stop_bit;               // Первая граница кода >= end_bit
+    int error;                   // 1 - встречен NULL узел
+    unsigned char *out;          // Декодированные символы
+    long out_len;                // Количество декодированных символов
+    long out_cap;                // Емкость буфера out
+    long starts[PARALLEL_SYNC_WINDOW]; // Позиции начал первых кодов участка
+    int start_count;             // Количество записанных позиций
+    long skip;                   // Сколько первых символов отбросить (до синхронизации)
+    unsigned char tail[PARALLEL_SYNC_WINDOW]; // Символы от stop_bit до синхронизации со следующим
+    int tail_len;                // Количество символов в tail
+    int synced;                  // 1 - стык со следующим участком проверен
+    long redo_from;              // Позиция для повторного декодирования (-1 - не нужно)
+} DecodeChunk;
+
+// Добавление символа в выходной буфер участка
+static void append_symbol(DecodeChunk *chunk, unsigned char symbol) {
+    if (chunk->out_len == chunk->out_cap) {
+        chunk->out_cap = (chunk->out_cap > 0) ? chunk->out_cap * 2 : 4096;
+        chunk->out = (unsigned char*)realloc(chunk->out, chunk->out_cap);
+        if (chunk->out == NULL) {
+            perror("Не удалось выделить память для декодирования");
+            exit(1);
+        }
+    }
+    chunk->out[chunk->out_len++] = symbol;
+}
+
+// Декодирование одного кода с позиции *pos.
+// Возвращает символ, -1 при незавершенном коде в конце потока, -2 при NULL узле
+static int decode_symbol(DecodeChunk *chunk, long *pos) {
+    HuffmanNode *current = chunk->root;
+    long p = *pos;
+    do {
+        if (p == chunk->total_bits) return -1;
+        int bit = (chunk->data[p >> 3] >> (7 - (p & 7))) & 1;
+        p++;
+        current = bit ? current->right : current->left;
+        if (current == NULL) return -2;
+    } while (current->left != NULL || current->right != NULL);
+    *pos = p;
+    return current->symbol;
+}
+
+// Декодирование участка начиная с позиции from_bit:
+// декодируются все коды, начинающиеся до end_bit
+static void decode_chunk(DecodeChunk *chunk, long from_bit) {
+    long pos = from_bit;
+    chunk->start_bit = from_bit;
+    chunk->out_len = 0;
+    chunk->start_count = 0;
+    chunk->error = 0;
+    chunk->skip = 0;
+
+    while (pos < chunk->end_bit) {
+        // Запоминаем начало кода для последующей синхронизации
+        if (chunk->start_count < PARALLEL_SYNC_WINDOW) {
+            chunk->starts[chunk->start_count++] = pos;
+        }
+
+        int symbol = decode_symbol(chunk, &pos);
+        if (symbol == -1) {
+            // Незавершенный код в конце потока (биты выравнивания)
+            pos = chunk->total_bits;
+            break;
+        }
+        if (symbol == -2) {
+            chunk->error = 1;
+            break;
+        }
+        append_symbol(chunk, (unsigned char)symbol);
+    }
+    chunk->stop_bit = pos;
+}
+
+// Проверка стыка участка со следующим: от stop_bit продолжаем декодирование,
+// пока позиция не совпадет с одним из записанных начал кодов следующего участка.
+// Если совпадения нет, следующий участок помечается для повторного декодирования.
+static void sync_with_next(DecodeChunk *chunk) {
+    DecodeChunk *next = chunk->next;
+    long pos = chunk->stop_bit;
+    int j = 0;
+    chunk->tail_len = 0;
+    chunk->synced = 1;
+
+    while (chunk->tail_len < PARALLEL_SYNC_WINDOW) {
+        while (j < next->start_count && next->starts[j] < pos) j++;
+        if (j < next->start_count && next->starts[j] == pos) {
+            // Начиная с этой позиции вывод следующего участка совпадает с истинным
+            next->skip = j;
+            next->redo_from = -1;
+            return;
+        }
+        if (pos == next->stop_bit && pos >= next->end_bit) {
+            // Ни один код следующего участка не начинается на его территории
+            next->skip = next->out_len;
+            next->redo_from = -1;
+            return;
+        }
+        if (j == next->start_count) break;
+
+        int symbol = decode_symbol(chunk, &pos);
+        if (symbol < 0) break;
+        chunk->tail[chunk->tail_len++] = (unsigned char)symbol;
+    }
+
+    // Синхронизация не найдена - следующий участок декодируется заново с stop_bit
+    chunk->tail_len = 0;
+    next->redo_from = chunk->stop_bit;
+}
+
+// Точки входа потоков для каждой фазы
+static void* speculative_thread(void *arg) {
+    DecodeChunk *chunk = (DecodeChunk*)arg;
+    decode_chunk(chunk, chunk->start_bit);
+    return NULL;
+}
+
+static void* sync_thread(void *arg) {
+    sync_with_next((DecodeChunk*)arg);
+    return NULL;
+}
+
+static void* redo_thread(void *arg) {
+    DecodeChunk *chunk = (DecodeChunk*)arg;
+    decode_chunk(chunk, chunk->redo_from);
+    chunk->redo_from = -1;
+    chunk->synced = (chunk->next == NULL); // Изменился конец участка - стык проверяется заново
+    return NULL;
+}
+
+// Запуск функции для списка участков: по потоку на участок, первый - в текущем
+static void run_parallel(void* (*func)(void*), DecodeChunk **work, int count) {
+    pthread_t tids[PARALLEL_MAX_THREADS];
+    for (int i = 1; i < count; i++) {
+        if (pthread_create(&tids[i], NULL, func, work[i]) != 0) {
+            perror("Не удалось создать поток");
+            exit(1);
+        }
+    }
+    if (count > 0) func(work[0]);
+    for (int i = 1; i < count; i++) {
+        pthread_join(tids[i], NULL);
+    }
+}
+
+// Параллельное декодирование файла.
+// Поток делится на участки по PARALLEL_CHUNK_BYTES байт, которые обрабатываются
+// пачками по числу потоков. Каждый поток начинает с начала байта и полагается на
+// самосинхронизацию кодов Хаффмана. Затем, также параллельно, каждый участок
+// продолжает декодирование за своим концом, пока не совпадет с началами кодов
+// следующего. При несовпадении следующий участок декодируется заново с конца
+// предыдущего; проверка повторяется, пока все стыки пачки не будут подтверждены.
+// Каждый раунд подтверждает хотя бы один участок, поэтому раундов не больше,
+// чем участков в пачке.
+// В худшем случае (коды не синхронизируются) скорость падает до последовательной.
+void parallel_decode_file(const char *input_file, const char *output_file, int threads) {
+    printf("1. Чтение дерева Хаффмана из файла...\n");
+
+    // Открытие файлов
+    BitStream *input = open_bit_stream(input_file, "rb");
+    FILE *output = fopen(output_file, "wb");
+
+    if (!input || !output) {
+        perror("Ошибка открытия файлов");
+        exit(1);
+    }
+
+    long expected_bytes;
+    fread(&expected_bytes, sizeof(long), 1, input->file);
+    printf("   Ожидается символов: %ld\n", expected_bytes);
+
+    // Чтение дерева из заголовка
+    HuffmanNode *root = read_tree_header(input);
+    if (root == NULL) {
+        printf("Ошибка: не удалось прочитать дерево Хаффмана\n");
+        exit(1);
+    }
+
+    // Отображение файла в память (без копирования данных)
+    long data_offset = ftell(input->file);
+    fseek(input->file, 0, SEEK_END);
+    long file_size = ftell(input->file);
+    long data_size = file_size - data_offset;
+
+    unsigned char *map = (unsigned char*)mmap(NULL, file_size, PROT_READ, MAP_PRIVATE,
+                                              fileno(input->file), 0);
+    if (map == MAP_FAILED) {
+        perror("Не удалось отобразить файл в память");
+        exit(1);
+    }
+    close_bit_stream(input);
+
+    // Выбор количества потоков
+    long total_bits = data_size * 8;
+    long total_chunks = (data_size + PARALLEL_CHUNK_BYTES - 1) / PARALLEL_CHUNK_BYTES;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (int)cpus : 1;
+    }
+    if (threads > PARALLEL_MAX_THREADS) threads = PARALLEL_MAX_THREADS;
+    if (threads > total_chunks) threads = (int)total_chunks;
+    if (threads < 1) threads = 1;
+
+    printf("2. Параллельное декодирование данных (потоков: %d)...\n", threads);
+    DecodeChunk *chunks = (DecodeChunk*)calloc(threads, sizeof(DecodeChunk));
+    DecodeChunk *work[PARALLEL_MAX_THREADS];
+    long decoded_bytes = 0;
+    long resynced = 0;
+    long redecoded = 0;
+    long boundary = 0; // Истинная граница кода, с которой начинается очередная пачка
+    int failed = 0;
+
+    for (long first = 0; first < total_chunks && !failed &&
+                         decoded_bytes < expected_bytes; first += threads) {
+        int count = (total_chunks - first < threads) ? (int)(total_chunks - first) : threads;
+
+        for (int i = 0; i < count; i++) {
+            DecodeChunk *chunk = &chunks[i];
+            chunk->data = map + data_offset;
+            chunk->total_bits = total_bits;
+            chunk->root = root;
+            chunk->next = (i + 1 < count) ? &chunks[i + 1] : NULL;
+            chunk->start_bit = (first + i) * PARALLEL_CHUNK_BYTES * 8;
+            chunk->end_bit = (first + i + 1) * PARALLEL_CHUNK_BYTES * 8;
+            if (chunk->end_bit > total_bits) chunk->end_bit = total_bits;
+            chunk->tail_len = 0;
+            chunk->synced = (chunk->next == NULL);
+            chunk->redo_from = -1;
+            work[i] = chunk;
+        }
+        // Первый участок пачки начинается с истинной границы
+        chunks[0].start_bit = boundary;
+        run_parallel(speculative_thread, work, count);
+
+        // Параллельная проверка стыков, пока все не будут подтверждены
+        for (;;) {
+            int pending = 0;
+            for (int i = 0; i < count; i++) {
+                if (!chunks[i].synced) work[pending++] = &chunks[i];
+            }
+            run_parallel(sync_thread, work, pending);
+            for (int i = 0; i < pending; i++) {
+                if (work[i]->next->redo_from < 0) resynced++;
+            }
+
+            // Участок декодируется заново, только если предыдущий не ждет того же:
+            // иначе его начальная позиция заведомо устарела
+            int redo = 0;
+            for (int i = 0; i < count; i++) {
+                if (chunks[i].redo_from >= 0 && (i == 0 || chunks[i - 1].redo_from < 0)) {
+                    work[redo++] = &chunks[i];
+                }
+            }
+            if (redo == 0) break;
+            redecoded += redo;
+            run_parallel(redo_thread, work, redo);
+        }
+
+        // Запись подтвержденных участков пачки
+        for (int i = 0; i < count && decoded_bytes < expected_bytes; i++) {
+            DecodeChunk *chunk = &chunks[i];
+
+            long n = chunk->out_len - chunk->skip;
+            if (n > expected_bytes - decoded_bytes) n = expected_bytes - decoded_bytes;
+            fwrite(chunk->out + chunk->skip, 1, n, output);
+            decoded_bytes += n;
+
+            if (chunk->error) {
+                printf("ОШИБКА: NULL узел!\n");
+                failed = 1;
+                break;
+            }
+
+            n = chunk->tail_len;
+            if (n > expected_bytes - decoded_bytes) n = expected_bytes - decoded_bytes;
+            fwrite(chunk->tail, 1, n, output);
+            decoded_bytes += n;
+        }
+        boundary = chunks[count - 1].stop_bit;
+
+        // Освобождаем уже декодированные страницы отображения
+        long page = sysconf(_SC_PAGESIZE);
+        long done = (data_offset + boundary / 8) / page * page;
+        if (done > 0) madvise(map, done, MADV_DONTNEED);
+    }
+    printf("   Синхронизировано стыков: %ld, декодировано заново: %ld\n", resynced, redecoded);
+
+    // Закрытие файлов и освобождение памяти
+    fclose(output);
+    for (int i = 0; i < threads; i++) {
+        free(chunks[i].out);
+    }
+    free(chunks);
+    munmap(map, file_size);
+    free_huffman_tree(root);
+
+    printf("Декодирование завершено успешно!\n");
+    printf("  Декодировано байт: %ld\n", decoded_bytes);
+    printf("  Результат: %s -> %s\n", input_file, output_file);
+}
@@ -0,0 +1,7 @@
+#ifndef PARALLEL_DECODE_H
+#define PARALLEL_DECODE_H
+
+// Параллельное декодирование файла (threads <= 0 - по числу ядер)
+void parallel_decode_file(const char *input_file, const char *output_file, int threads);
+
+#endif